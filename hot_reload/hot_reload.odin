@@ -36,19 +36,20 @@ copy_dll :: proc(to: string) -> bool {
 }
 
 yume_API :: struct {
-	lib:               dynlib.Library,
-	init_window:       proc(),
-	init:              proc(),
-	update:            proc() -> bool,
-	shutdown:          proc(),
-	shutdown_window:   proc(),
-	memory:            proc() -> rawptr,
-	memory_size:       proc() -> int,
-	hot_reloaded:      proc(mem: rawptr),
-	force_reload:      proc() -> bool,
-	force_restart:     proc() -> bool,
-	modification_time: os.File_Time,
-	api_version:       int,
+	lib:                 dynlib.Library,
+	init_window:         proc(),
+	init:                proc(),
+	update:              proc() -> bool,
+	profile_allocations: proc(count, bytes: int),
+	shutdown:            proc(),
+	shutdown_window:     proc(),
+	memory:              proc() -> rawptr,
+	memory_size:         proc() -> int,
+	hot_reloaded:        proc(mem: rawptr),
+	force_reload:        proc() -> bool,
+	force_restart:       proc() -> bool,
+	modification_time:   os.File_Time,
+	api_version:         int,
 }
 
 load_yume_api :: proc(api_version: int) -> (api: yume_API, ok: bool) {
@@ -133,7 +134,14 @@ main :: proc() {
 
 	window_open := true
 	for window_open {
+		alloc_count := tracking_allocator.total_allocation_count
+		alloc_bytes := tracking_allocator.total_memory_allocated
+
 		window_open = yume_api.update()
+		yume_api.profile_allocations(
+			int(tracking_allocator.total_allocation_count - alloc_count),
+			int(tracking_allocator.total_memory_allocated - alloc_bytes),
+		)
 		force_reload := yume_api.force_reload()
 		force_restart := yume_api.force_restart()
 		reload := force_reload || force_restart
@@ -1,18 +1,27 @@
 package main
 
+import "core:fmt"
 import "core:log"
+import "core:mem"
 import "core:os"
+import "core:strconv"
 
 import yume "yume"
 
 USE_TRACKING_ALLOCATOR :: #config(USE_TRACKING_ALLOCATOR, false)
 
+_ :: mem // Only referenced when USE_TRACKING_ALLOCATOR is set
+
 main :: proc() {
+	if len(os.args) > 1 && os.args[1] == "render" {
+		os.exit(render_cli(os.args[2:]) ? 0 : 1)
+	}
+
 	when USE_TRACKING_ALLOCATOR {
 		default_allocator := context.allocator
-		tracking_allocator: Tracking_Allocator
-		tracking_allocator_init(&tracking_allocator, default_allocator)
-		context.allocator = allocator_from_tracking_allocator(&tracking_allocator)
+		tracking_allocator: mem.Tracking_Allocator
+		mem.tracking_allocator_init(&tracking_allocator, default_allocator)
+		context.allocator = mem.tracking_allocator(&tracking_allocator)
 	}
 
 	mode: int = 0
@@ -36,9 +45,19 @@ main :: proc() {
 
 	window_open := true
 	for window_open {
+		when USE_TRACKING_ALLOCATOR {
+			alloc_count := tracking_allocator.total_allocation_count
+			alloc_bytes := tracking_allocator.total_memory_allocated
+		}
+
 		window_open = yume.yume_update()
 
 		when USE_TRACKING_ALLOCATOR {
+			yume.yume_profile_allocations(
+				int(tracking_allocator.total_allocation_count - alloc_count),
+				int(tracking_allocator.total_memory_allocated - alloc_bytes),
+			)
+
 			for b in tracking_allocator.bad_free_array {
 				log.error("Bad free at: %v", b.location)
 			}
@@ -62,8 +81,51 @@ main :: proc() {
 			log.error("%v: Leaked %v bytes\n", value.location, value.size)
 		}
 
-		tracking_allocator_destroy(&tracking_allocator)
+		mem.tracking_allocator_destroy(&tracking_allocator)
+	}
+}
+
+// Headless replay of a saved op log, no window needed:
+//   yume render <op log> <out.png> [scale] [threads]
+render_cli :: proc(args: []string) -> bool {
+	if len(args) < 2 {
+		fmt.eprintln("usage: yume render <op log> <out.png> [scale] [threads]")
+		return false
+	}
+
+	scale: f32 = 1
+	if len(args) > 2 {
+		value, ok := strconv.parse_f32(args[2])
+		if !ok || value <= 0 {
+			fmt.eprintln("invalid scale:", args[2])
+			return false
+		}
+		scale = value
+	}
+
+	threads := 0
+	if len(args) > 3 {
+		value, ok := strconv.parse_int(args[3])
+		if !ok || value < 0 {
+			fmt.eprintln("invalid thread count:", args[3])
+			return false
+		}
+		threads = value
+	}
+
+	switch yume.render_oplog_to_png(args[0], args[1], scale, threads) {
+	case .None:
+		return true
+	case .Load:
+		fmt.eprintln("failed to load op log:", args[0])
+	case .TooLarge:
+		fmt.eprintln("output is too large to export at scale", scale)
+	case .OutOfMemory:
+		fmt.eprintln("not enough memory to render at scale", scale)
+	case .Export:
+		fmt.eprintln("failed to write", args[1])
 	}
+	return false
 }
 
 @(export)
@@ -0,0 +1,3 @@
+#!/usr/bin/env bash
+
+odin test tests -strict-style -vet
@@ -0,0 +1,120 @@
+package tests
+
+import "core:os"
+import "core:slice"
+import "core:testing"
+import rl "vendor:raylib"
+
+import yume "../yume"
+
+// Tests run in parallel, so each one writes its own file
+OPLOG_ROUND_TRIP_PATH :: "oplog_round_trip.yumelog"
+OPLOG_CORRUPT_PATH :: "oplog_corrupt.yumelog"
+
+// Fixed 64x48 canvas holding a stroke and a 2x3 image, no window needed
+make_test_canvas :: proc() -> yume.Canvas {
+	canvas := yume.Canvas {
+		mode = .Fixed,
+	}
+	canvas.texture.texture.width = 64
+	canvas.texture.texture.height = 48
+	canvas.history.operations = make([dynamic]yume.Operation)
+
+	append(
+		&canvas.history.operations,
+		yume.Operation {
+			type = yume.StrokeOperation {
+				points = slice.clone([]rl.Vector2{{10, 20}, {30, 40}, {50, 45}}),
+				color = rl.RED,
+				size = 6,
+			},
+			timestamp = 1,
+			visible = true,
+		},
+	)
+	append(
+		&canvas.history.operations,
+		yume.Operation {
+			type = yume.ImageOperation {
+				image = rl.GenImageColor(2, 3, rl.BLUE),
+				pos = {5, 7},
+				width = 2,
+				height = 3,
+			},
+			timestamp = 2,
+			visible = true,
+		},
+	)
+	canvas.history.curr_index = 1
+
+	return canvas
+}
+
+@(test)
+oplog_round_trip :: proc(t: ^testing.T) {
+	canvas := make_test_canvas()
+	defer yume.destroy_history(&canvas.history)
+
+	testing.expect(t, yume.save_history(&canvas, OPLOG_ROUND_TRIP_PATH))
+	defer os.remove(OPLOG_ROUND_TRIP_PATH)
+
+	history, header, ok := yume.load_history(OPLOG_ROUND_TRIP_PATH)
+	if !testing.expect(t, ok) do return
+	defer yume.destroy_history(&history)
+
+	testing.expect_value(t, header.width, 64)
+	testing.expect_value(t, header.height, 48)
+	testing.expect_value(t, header.origin, rl.Vector2{0, 0})
+	testing.expect_value(t, len(history.operations), 2)
+	testing.expect_value(t, history.curr_index, 1)
+
+	saved_stroke := canvas.history.operations[0].type.(yume.StrokeOperation)
+	stroke, is_stroke := history.operations[0].type.(yume.StrokeOperation)
+	if testing.expect(t, is_stroke) {
+		testing.expect(t, slice.equal(stroke.points, saved_stroke.points))
+		testing.expect_value(t, stroke.color, rl.RED)
+		testing.expect_value(t, stroke.size, 6)
+		testing.expect_value(t, history.operations[0].timestamp, 1)
+	}
+
+	saved_image := canvas.history.operations[1].type.(yume.ImageOperation)
+	image, is_image := history.operations[1].type.(yume.ImageOperation)
+	if testing.expect(t, is_image) {
+		testing.expect_value(t, image.pos, rl.Vector2{5, 7})
+		testing.expect_value(t, image.width, 2)
+		testing.expect_value(t, image.height, 3)
+		testing.expect_value(t, image.texture.id, 0)
+
+		pixels := ([^]rl.Color)(image.image.data)[:6]
+		saved_pixels := ([^]rl.Color)(saved_image.image.data)[:6]
+		testing.expect(t, slice.equal(pixels, saved_pixels))
+	}
+}
+
+@(test)
+oplog_rejects_corrupt_files :: proc(t: ^testing.T) {
+	canvas := make_test_canvas()
+	defer yume.destroy_history(&canvas.history)
+
+	testing.expect(t, yume.save_history(&canvas, OPLOG_CORRUPT_PATH))
+	defer os.remove(OPLOG_CORRUPT_PATH)
+
+	data, ok := os.read_entire_file(OPLOG_CORRUPT_PATH)
+	if !testing.expect(t, ok) do return
+	defer delete(data)
+
+	// Truncated image payload
+	testing.expect(t, os.write_entire_file(OPLOG_CORRUPT_PATH, data[:len(data) - 1]))
+	_, _, loaded := yume.load_history(OPLOG_CORRUPT_PATH)
+	testing.expect(t, !loaded)
+
+	// Point count far past the end of the file
+	point_count_offset :=
+		size_of(yume.OpLogHeader) +
+		size_of(yume.OpLogEntry) +
+		offset_of(yume.OpLogStroke, point_count)
+	(^u32)(&data[point_count_offset])^ = max(u32)
+	testing.expect(t, os.write_entire_file(OPLOG_CORRUPT_PATH, data))
+	_, _, loaded = yume.load_history(OPLOG_CORRUPT_PATH)
+	testing.expect(t, !loaded)
+}
@@ -0,0 +1,113 @@
+package tests
+
+import "core:encoding/json"
+import "core:os"
+import "core:testing"
+
+import yume "../yume"
+
+PROFILER_TEST_TRACE_PATH :: "profiler_test_trace.json"
+
+@(test)
+profiler_ring_keeps_newest_frames :: proc(t: ^testing.T) {
+	// Too big for a comfortable stack frame
+	profiler := new(yume.Profiler)
+	defer free(profiler)
+
+	yume.profile_begin_frame(profiler)
+	testing.expect_value(t, yume.get_completed_frame_count(profiler), 0)
+
+	frame_total := yume.PROFILER_FRAME_COUNT + 10
+	for i in 0 ..< frame_total {
+		if i > 0 do yume.profile_begin_frame(profiler)
+		yume.record_zone(profiler, .Frame, f64(i) * 1000, f64(i))
+	}
+
+	// The last frame is still in progress
+	testing.expect_value(t, yume.get_completed_frame_count(profiler), yume.PROFILER_FRAME_COUNT)
+	testing.expect_value(t, yume.get_completed_frame(profiler, 1).duration[.Frame], f64(frame_total - 2))
+	testing.expect_value(
+		t,
+		yume.get_completed_frame(profiler, yume.PROFILER_FRAME_COUNT).duration[.Frame],
+		f64(frame_total - 1 - yume.PROFILER_FRAME_COUNT),
+	)
+	testing.expect_value(t, yume.get_current_frame(profiler).duration[.Frame], f64(frame_total - 1))
+}
+
+@(test)
+profiler_zone_percentiles :: proc(t: ^testing.T) {
+	profiler := new(yume.Profiler)
+	defer free(profiler)
+
+	// Completed frames take 1..100 µs in update
+	for i in 1 ..= 100 {
+		yume.profile_begin_frame(profiler)
+		yume.record_zone(profiler, .Update, 0, f64(i))
+	}
+	yume.profile_begin_frame(profiler)
+
+	p50, p99 := yume.get_zone_percentiles(profiler, .Update)
+	testing.expect_value(t, p50, 51)
+	testing.expect_value(t, p99, 100)
+
+	// Entries within a frame are summed
+	yume.record_zone(profiler, .Update, 0, 1000)
+	yume.record_zone(profiler, .Update, 0, 1000)
+	yume.profile_begin_frame(profiler)
+	p50, p99 = yume.get_zone_percentiles(profiler, .Update)
+	testing.expect_value(t, p99, 2000)
+}
+
+@(test)
+profiler_exports_ordered_trace :: proc(t: ^testing.T) {
+	profiler := new(yume.Profiler)
+	defer free(profiler)
+
+	// Zones are recorded as they end, children before their parents
+	for i in 0 ..< 3 {
+		base := f64(i) * 100
+		yume.profile_begin_frame(profiler)
+		yume.record_zone(profiler, .UpdateCanvas, base + 1, 1)
+		yume.record_zone(profiler, .UpdateCanvas, base + 3, 1)
+		yume.record_zone(profiler, .Update, base, 5)
+		yume.record_zone(profiler, .DrawMenu, base + 6, 1)
+		yume.record_zone(profiler, .DrawToolbar, base + 8, 1)
+		yume.record_zone(profiler, .Draw, base + 5, 5)
+		yume.record_zone(profiler, .Present, base + 10, 2)
+		yume.record_zone(profiler, .Frame, base, 12)
+	}
+	yume.profile_begin_frame(profiler)
+
+	testing.expect(t, yume.export_chrome_trace(profiler, PROFILER_TEST_TRACE_PATH))
+	defer os.remove(PROFILER_TEST_TRACE_PATH)
+
+	data, ok := os.read_entire_file(PROFILER_TEST_TRACE_PATH)
+	if !testing.expect(t, ok) do return
+	defer delete(data)
+
+	value, err := json.parse(data)
+	if !testing.expect_value(t, err, json.Error.None) do return
+	defer json.destroy_value(value)
+
+	root, is_object := value.(json.Object)
+	if !testing.expect(t, is_object) do return
+	events, is_array := root["traceEvents"].(json.Array)
+	if !testing.expect(t, is_array) do return
+
+	// Per frame: two counters and the six zones entered once
+	testing.expect_value(t, len(events), 3 * 8)
+
+	last_ts := -1.0
+	for event in events {
+		fields, is_event := event.(json.Object)
+		if !testing.expect(t, is_event) do return
+
+		ts, has_ts := fields["ts"].(json.Float)
+		if !testing.expect(t, has_ts) do return
+		testing.expectf(t, ts >= last_ts, "event at %v after %v", ts, last_ts)
+		last_ts = ts
+
+		name, _ := fields["name"].(json.String)
+		testing.expect(t, name != "update_canvas", "re-entered zone was exported")
+	}
+}
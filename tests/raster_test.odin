@@ -0,0 +1,178 @@
+package tests
+
+import "core:os"
+import "core:slice"
+import "core:testing"
+import rl "vendor:raylib"
+
+import yume "../yume"
+
+RASTER_TEST_WIDTH :: 200
+RASTER_TEST_HEIGHT :: 150
+RASTER_TEST_LOG_PATH :: "raster_test.yumelog"
+
+// A horizontal stroke crossing several tiles, a click dot and a 4x4 image
+make_test_history :: proc() -> yume.History {
+	history := yume.History {
+		operations = make([dynamic]yume.Operation),
+	}
+
+	append(
+		&history.operations,
+		yume.Operation {
+			type = yume.StrokeOperation {
+				points = slice.clone([]rl.Vector2{{20, 75}, {180, 75}}),
+				color = rl.BLACK,
+				size = 10,
+			},
+			visible = true,
+		},
+	)
+	append(
+		&history.operations,
+		yume.Operation {
+			type = yume.StrokeOperation {
+				points = slice.clone([]rl.Vector2{{40, 30}}),
+				color = rl.RED,
+				size = 6,
+			},
+			visible = true,
+		},
+	)
+	append(
+		&history.operations,
+		yume.Operation {
+			type = yume.ImageOperation {
+				image = rl.GenImageColor(4, 4, rl.BLUE),
+				pos = {150, 10},
+				width = 4,
+				height = 4,
+			},
+			visible = true,
+		},
+	)
+	history.curr_index = 2
+
+	return history
+}
+
+get_pixel :: proc(buffer: yume.RasterBuffer, x, y: int) -> rl.Color {
+	return buffer.pixels[y * int(buffer.width) + x]
+}
+
+@(test)
+rasterize_known_ops :: proc(t: ^testing.T) {
+	history := make_test_history()
+	defer yume.destroy_history(&history)
+
+	buffer, err := yume.create_raster_buffer(RASTER_TEST_WIDTH, RASTER_TEST_HEIGHT)
+	if !testing.expect(t, err == nil) do return
+	defer yume.destroy_raster_buffer(&buffer)
+
+	yume.rasterize_history(&history, &buffer, thread_count = 1)
+
+	// Stroke: radius 5 around y = 75
+	testing.expect_value(t, get_pixel(buffer, 100, 75), rl.BLACK)
+	testing.expect_value(t, get_pixel(buffer, 100, 79), rl.BLACK)
+	testing.expect_value(t, get_pixel(buffer, 100, 60), rl.WHITE)
+	testing.expect_value(t, get_pixel(buffer, 10, 75), rl.WHITE)
+
+	// Dot: radius is the full brush size, like update_drawing
+	testing.expect_value(t, get_pixel(buffer, 40, 30), rl.RED)
+	testing.expect_value(t, get_pixel(buffer, 44, 30), rl.RED)
+	testing.expect_value(t, get_pixel(buffer, 40, 38), rl.WHITE)
+
+	// Image covers [150, 154) x [10, 14)
+	testing.expect_value(t, get_pixel(buffer, 150, 10), rl.BLUE)
+	testing.expect_value(t, get_pixel(buffer, 153, 13), rl.BLUE)
+	testing.expect_value(t, get_pixel(buffer, 154, 13), rl.WHITE)
+	testing.expect_value(t, get_pixel(buffer, 153, 14), rl.WHITE)
+}
+
+@(test)
+rasterize_scaled :: proc(t: ^testing.T) {
+	history := make_test_history()
+	defer yume.destroy_history(&history)
+
+	buffer, err := yume.create_raster_buffer(RASTER_TEST_WIDTH * 2, RASTER_TEST_HEIGHT * 2)
+	if !testing.expect(t, err == nil) do return
+	defer yume.destroy_raster_buffer(&buffer)
+
+	yume.rasterize_history(&history, &buffer, scale = 2, thread_count = 1)
+
+	testing.expect_value(t, get_pixel(buffer, 200, 158), rl.BLACK)
+	testing.expect_value(t, get_pixel(buffer, 200, 120), rl.WHITE)
+	testing.expect_value(t, get_pixel(buffer, 307, 27), rl.BLUE)
+	testing.expect_value(t, get_pixel(buffer, 308, 27), rl.WHITE)
+}
+
+@(test)
+rasterize_threads_match_serial :: proc(t: ^testing.T) {
+	history := make_test_history()
+	defer yume.destroy_history(&history)
+
+	serial, serial_err := yume.create_raster_buffer(RASTER_TEST_WIDTH, RASTER_TEST_HEIGHT)
+	if !testing.expect(t, serial_err == nil) do return
+	defer yume.destroy_raster_buffer(&serial)
+
+	parallel, parallel_err := yume.create_raster_buffer(RASTER_TEST_WIDTH, RASTER_TEST_HEIGHT)
+	if !testing.expect(t, parallel_err == nil) do return
+	defer yume.destroy_raster_buffer(&parallel)
+
+	yume.rasterize_history(&history, &serial, thread_count = 1)
+	yume.rasterize_history(&history, &parallel, thread_count = 4)
+
+	mismatched, max_delta := yume.diff_raster(serial, parallel)
+	testing.expect_value(t, mismatched, 0)
+	testing.expect_value(t, max_delta, 0)
+	testing.expect(t, slice.equal(serial.pixels, parallel.pixels))
+}
+
+@(test)
+rasterize_clips_offscreen_segments :: proc(t: ^testing.T) {
+	// A curve starting far outside the buffer, so most of its segments are binned away
+	history := yume.History {
+		operations = make([dynamic]yume.Operation),
+	}
+	defer yume.destroy_history(&history)
+
+	append(
+		&history.operations,
+		yume.Operation {
+			type = yume.StrokeOperation {
+				points = slice.clone([]rl.Vector2{{-5000, 10}, {-2000, 10}, {100, 10}, {190, 10}}),
+				color = rl.BLACK,
+				size = 4,
+			},
+			visible = true,
+		},
+	)
+
+	buffer, err := yume.create_raster_buffer(RASTER_TEST_WIDTH, RASTER_TEST_HEIGHT)
+	if !testing.expect(t, err == nil) do return
+	defer yume.destroy_raster_buffer(&buffer)
+
+	yume.rasterize_history(&history, &buffer, thread_count = 1)
+
+	testing.expect_value(t, get_pixel(buffer, 0, 10), rl.BLACK)
+	testing.expect_value(t, get_pixel(buffer, 150, 10), rl.BLACK)
+	testing.expect_value(t, get_pixel(buffer, 150, 20), rl.WHITE)
+	testing.expect_value(t, get_pixel(buffer, 199, 149), rl.WHITE)
+}
+
+@(test)
+render_rejects_oversized_output :: proc(t: ^testing.T) {
+	canvas := yume.Canvas {
+		mode = .Fixed,
+	}
+	canvas.texture.texture.width = 800
+	canvas.texture.texture.height = 600
+	canvas.history.curr_index = -1
+
+	testing.expect(t, yume.save_history(&canvas, RASTER_TEST_LOG_PATH))
+	defer os.remove(RASTER_TEST_LOG_PATH)
+
+	// 56000 x 42000 pixels, past what raylib can export
+	result := yume.render_oplog_to_png(RASTER_TEST_LOG_PATH, "oversized.png", 70)
+	testing.expect_value(t, result, yume.RenderError.TooLarge)
+}
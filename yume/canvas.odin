@@ -83,10 +83,7 @@ create_canvas :: proc(width, height: i32, infinite := false, mode := CanvasMode.
 }
 
 destroy_canvas :: proc(canvas: ^Canvas) {
-	for op in canvas.history.operations {
-		destroy_op(op)
-	}
-	delete(canvas.history.operations)
+	destroy_history(&canvas.history)
 	rl.UnloadRenderTexture(canvas.texture)
 }
 
@@ -125,6 +122,8 @@ resize_canvas :: proc(canvas: ^Canvas, new_width, new_height: i32) {
 }
 
 update_canvas :: proc(canvas: ^Canvas) {
+	profile_zone(.UpdateCanvas)
+
 	// Handle zooming
 	wheel := rl.GetMouseWheelMove()
 	if rl.IsKeyDown(.LEFT_CONTROL) && wheel != 0.0 {
@@ -244,6 +243,8 @@ clamp_camera_bounds :: proc(canvas: ^Canvas) {
 }
 
 draw_canvas :: proc(canvas: ^Canvas) {
+	profile_zone(.DrawCanvas)
+
 	screen := camera_to_screen_coords(canvas)
 	scale_x, scale_y := get_scale(canvas, screen)
 
@@ -282,10 +283,20 @@ draw_fixed_canvas :: proc(canvas: ^Canvas, screen: rl.Rectangle, scale_x, scale_
 }
 
 draw_infinite_canvas :: proc(canvas: ^Canvas, screen: rl.Rectangle, scale_x, scale_y: f32) {
+	drawn, culled := 0, 0
+	defer profile_count_ops(drawn, culled)
+
 	for i := 0; i <= canvas.history.curr_index; i += 1 {
 		op := canvas.history.operations[i]
 		if !op.visible do continue
 
+		// screen is the visible area in world coordinates
+		if !is_operation_visible(op, screen) {
+			culled += 1
+			continue
+		}
+		drawn += 1
+
 		switch o in op.type {
 		case StrokeOperation:
 			draw_stroke(canvas, o.points, o.color, o.size, screen, scale_x, scale_y)
@@ -415,6 +426,8 @@ draw_stroke :: proc(
 }
 
 update_drawing :: proc(state: ^State, color: rl.Color) {
+	profile_zone(.UpdateDrawing)
+
 	if state.canvas.is_dragging do return
 
 	mouse_pos := rl.GetMousePosition()
@@ -435,6 +448,7 @@ update_drawing :: proc(state: ^State, color: rl.Color) {
 					color,
 					i32(state.brush_size),
 				)
+				profile_count_ops(1, 0)
 			}
 		}
 	} else if state.draw_state.is_drawing {
@@ -443,6 +457,7 @@ update_drawing :: proc(state: ^State, color: rl.Color) {
 			rl.BeginTextureMode(state.canvas.texture)
 			rl.DrawCircleV(state.draw_state.points[0], f32(state.brush_size), color)
 			rl.EndTextureMode()
+			profile_count_ops(1, 0)
 		}
 
 		copied_points := clone_points(state.draw_state.points[:])
@@ -554,6 +569,7 @@ draw_image :: proc(
 		type      = OperationVariant(
 			ImageOperation {
 				texture = texture,
+				image = rl.ImageCopy(image),
 				width = image.width,
 				height = image.height,
 				pos = pos,
@@ -705,6 +721,15 @@ is_operation_visible :: proc(op: Operation, view_bounds: rl.Rectangle) -> bool {
 	switch o in op.type {
 	case StrokeOperation:
 		bounds = get_points_bounds(o.points)
+
+		// Brushes wider than the default padding would otherwise pop out at the edges
+		extra := max(f32(o.size) / 2 - 10, 0)
+		bounds = {
+			bounds.x - extra,
+			bounds.y - extra,
+			bounds.width + extra * 2,
+			bounds.height + extra * 2,
+		}
 	case ImageOperation:
 		bounds = rl.Rectangle{o.pos.x, o.pos.y, f32(o.width), f32(o.height)}
 	}
@@ -1,5 +1,6 @@
 package yume
 
+import "core:log"
 import rl "vendor:raylib"
 
 MenuItem :: struct {
@@ -49,6 +50,7 @@ menus := []Menu {
 			{label = "Show Grid", shortcut = "Ctrl+G", enabled = true},
 			{label = "Actual Size", shortcut = "Ctrl+0", enabled = true},
 			{label = "Infinite Canvas", shortcut = "Ctrl+Alt+I", enabled = true},
+			{label = "Profiler", shortcut = "F3", enabled = true},
 		},
 	},
 	{
@@ -260,6 +262,8 @@ draw_menu_dropdown :: proc(menu: Menu, pos: rl.Vector2) {
 }
 
 draw_menu_bar :: proc() {
+	profile_zone(.DrawMenu)
+
 	menu_bar_bounds := rl.Rectangle{0, 0, state.window_size.x, MENUBAR_HEIGHT}
 
 	// Draw menu bar background
@@ -321,7 +325,12 @@ handle_menu_action :: proc(menu_label: string, item: MenuItem) {
 		case "Open...":
 		// TODO: Implement open dialog
 		case "Save":
-		// TODO: Implement save
+			// Relative to the working directory, build/ under the hot reload host
+			if save_history(&state.canvas, OPLOG_DEFAULT_PATH) {
+				log.infof("Saved history to %v", OPLOG_DEFAULT_PATH)
+			} else {
+				log.errorf("Failed to save history to %v", OPLOG_DEFAULT_PATH)
+			}
 		case "Save As...":
 		// TODO: Implement save as dialog
 		}
@@ -342,6 +351,8 @@ handle_menu_action :: proc(menu_label: string, item: MenuItem) {
 		switch item.label {
 		case "Infinite Canvas":
 			toggle_canvas_mode(&state.canvas)
+		case "Profiler":
+			state.profiler.show_overlay = !state.profiler.show_overlay
 		}
 	// Add other menu categories
 	}
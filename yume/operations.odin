@@ -16,6 +16,7 @@ StrokeOperation :: struct {
 
 ImageOperation :: struct {
 	texture: rl.Texture2D,
+	image:   rl.Image, // CPU copy for saving and headless replay
 	pos:     rl.Vector2,
 	width:   i32,
 	height:  i32,
@@ -55,6 +56,9 @@ apply_op :: proc(canvas: ^Canvas, op: Operation) {
 	// rl.BeginTextureMode(canvas.texture)
 	// defer rl.EndTextureMode()
 
+	// Fixed mode undo replays every op through here, usually the slowest frames
+	profile_count_ops(1, 0)
+
 	switch op in op.type {
 	case StrokeOperation:
 		draw_stroke(canvas, op.points, op.color, op.size)
@@ -104,8 +108,19 @@ redo :: proc(canvas: ^Canvas) {
 destroy_op :: proc(op: Operation) {
 	switch o in op.type {
 	case ImageOperation:
-		rl.UnloadTexture(o.texture)
+		// Ops loaded from an op log have no texture when there is no window
+		if o.texture.id != 0 {
+			rl.UnloadTexture(o.texture)
+		}
+		rl.UnloadImage(o.image)
 	case StrokeOperation:
 		delete(o.points)
 	}
 }
+
+destroy_history :: proc(history: ^History) {
+	for op in history.operations {
+		destroy_op(op)
+	}
+	delete(history.operations)
+}
@@ -0,0 +1,241 @@
+package yume
+
+import "core:math"
+import "core:mem"
+import "core:os"
+import rl "vendor:raylib"
+
+OPLOG_MAGIC :: [4]u8{'Y', 'U', 'M', 'E'}
+OPLOG_VERSION :: 1
+OPLOG_DEFAULT_PATH :: "canvas.yumelog"
+
+// Binary op log layout (native endianness):
+//   OpLogHeader
+//   op_count x (OpLogEntry, payload)
+// Stroke payload: OpLogStroke followed by point_count rl.Vector2
+// Image payload:  OpLogImage followed by width * height RGBA8 pixels
+OpLogHeader :: struct #packed {
+	magic:    [4]u8,
+	version:  u32,
+	origin:   rl.Vector2, // World position of the canvas top-left corner
+	width:    i32,
+	height:   i32,
+	op_count: u32,
+}
+
+OpLogKind :: enum u8 {
+	Stroke,
+	Image,
+}
+
+OpLogEntry :: struct #packed {
+	kind:      OpLogKind,
+	visible:   bool,
+	timestamp: i64,
+}
+
+OpLogStroke :: struct #packed {
+	color:       rl.Color,
+	size:        i32,
+	point_count: u32,
+}
+
+OpLogImage :: struct #packed {
+	pos:    rl.Vector2,
+	width:  i32,
+	height: i32,
+}
+
+// Writes every op up to the current history index, i.e. what the canvas is showing
+save_history :: proc(canvas: ^Canvas, path: string) -> bool {
+	last := min(canvas.history.curr_index, len(canvas.history.operations) - 1)
+	ops := canvas.history.operations[:last + 1]
+
+	bounds := get_history_bounds(canvas, ops)
+	header := OpLogHeader {
+		magic    = OPLOG_MAGIC,
+		version  = OPLOG_VERSION,
+		origin   = {bounds.x, bounds.y},
+		width    = i32(math.ceil(bounds.width)),
+		height   = i32(math.ceil(bounds.height)),
+		op_count = u32(len(ops)),
+	}
+
+	buf := make([dynamic]u8)
+	defer delete(buf)
+
+	append(&buf, ..mem.ptr_to_bytes(&header))
+	for op in ops {
+		entry := OpLogEntry {
+			visible   = op.visible,
+			timestamp = op.timestamp,
+		}
+
+		switch o in op.type {
+		case StrokeOperation:
+			entry.kind = .Stroke
+			stroke := OpLogStroke {
+				color       = o.color,
+				size        = o.size,
+				point_count = u32(len(o.points)),
+			}
+			append(&buf, ..mem.ptr_to_bytes(&entry))
+			append(&buf, ..mem.ptr_to_bytes(&stroke))
+			append(&buf, ..mem.slice_to_bytes(o.points))
+		case ImageOperation:
+			entry.kind = .Image
+			image := OpLogImage {
+				pos    = o.pos,
+				width  = o.image.width,
+				height = o.image.height,
+			}
+			append(&buf, ..mem.ptr_to_bytes(&entry))
+			append(&buf, ..mem.ptr_to_bytes(&image))
+			append(&buf, ..mem.byte_slice(o.image.data, int(image.width) * int(image.height) * 4))
+		}
+	}
+
+	return os.write_entire_file(path, buf[:])
+}
+
+// Loads an op log without touching the GPU. Image ops only carry their CPU image.
+load_history :: proc(path: string) -> (history: History, header: OpLogHeader, ok: bool) {
+	data, read_ok := os.read_entire_file(path)
+	if !read_ok do return
+	defer delete(data)
+
+	offset := 0
+	read_value(data, &offset, &header) or_return
+	if header.magic != OPLOG_MAGIC || header.version != OPLOG_VERSION do return
+	if header.width < 0 || header.height < 0 do return
+
+	// Every op needs at least an entry, so a count the file can't hold is corrupt
+	if int(header.op_count) > (len(data) - offset) / size_of(OpLogEntry) do return
+
+	alloc_err: mem.Allocator_Error
+	history.operations, alloc_err = make([dynamic]Operation, 0, header.op_count)
+	if alloc_err != nil do return
+	history.max_entries = 10
+
+	for _ in 0 ..< header.op_count {
+		op, op_ok := read_op(data, &offset)
+		if !op_ok {
+			destroy_history(&history)
+			return {}, header, false
+		}
+		append(&history.operations, op)
+	}
+
+	history.curr_index = len(history.operations) - 1
+	return history, header, true
+}
+
+@(private = "file")
+read_op :: proc(data: []u8, offset: ^int) -> (op: Operation, ok: bool) {
+	entry: OpLogEntry
+	read_value(data, offset, &entry) or_return
+	op.visible = entry.visible
+	op.timestamp = entry.timestamp
+
+	switch entry.kind {
+	case .Stroke:
+		stroke: OpLogStroke
+		read_value(data, offset, &stroke) or_return
+
+		// Check the payload is there before allocating for it
+		if int(stroke.point_count) > (len(data) - offset^) / size_of(rl.Vector2) do return
+
+		points, alloc_err := make([]rl.Vector2, stroke.point_count)
+		if alloc_err != nil do return
+		if !read_slice(data, offset, points) {
+			delete(points)
+			return
+		}
+		op.type = StrokeOperation {
+			points = points,
+			color  = stroke.color,
+			size   = stroke.size,
+		}
+	case .Image:
+		image: OpLogImage
+		read_value(data, offset, &image) or_return
+		if image.width <= 0 || image.height <= 0 do return
+
+		// raylib sizes image data as an i32 byte count
+		pixel_count := int(image.width) * int(image.height)
+		if pixel_count > int(max(i32)) / size_of(rl.Color) do return
+		if pixel_count > (len(data) - offset^) / size_of(rl.Color) do return
+
+		pixels := rl.GenImageColor(image.width, image.height, rl.BLANK)
+		if pixels.data == nil do return
+		if !read_slice(data, offset, ([^]rl.Color)(pixels.data)[:pixel_count]) {
+			rl.UnloadImage(pixels)
+			return
+		}
+		op.type = ImageOperation {
+			image  = pixels,
+			pos    = image.pos,
+			width  = image.width,
+			height = image.height,
+		}
+	case:
+		return
+	}
+
+	return op, true
+}
+
+@(private = "file")
+read_value :: proc(data: []u8, offset: ^int, value: ^$T) -> bool {
+	if offset^ + size_of(T) > len(data) do return false
+	mem.copy(value, &data[offset^], size_of(T))
+	offset^ += size_of(T)
+	return true
+}
+
+@(private = "file")
+read_slice :: proc(data: []u8, offset: ^int, values: []$T) -> bool {
+	bytes := mem.slice_to_bytes(values)
+	if offset^ + len(bytes) > len(data) do return false
+	copy(bytes, data[offset^:])
+	offset^ += len(bytes)
+	return true
+}
+
+// Fixed canvases export their texture area, infinite ones the union of everything drawn
+get_history_bounds :: proc(canvas: ^Canvas, ops: []Operation) -> rl.Rectangle {
+	if canvas.mode == .Fixed || len(ops) == 0 {
+		return rl.Rectangle {
+			0,
+			0,
+			f32(canvas.texture.texture.width),
+			f32(canvas.texture.texture.height),
+		}
+	}
+
+	min_pos := rl.Vector2{math.F32_MAX, math.F32_MAX}
+	max_pos := rl.Vector2{-math.F32_MAX, -math.F32_MAX}
+	for op in ops {
+		if !op.visible do continue
+
+		switch o in op.type {
+		case StrokeOperation:
+			// Single point strokes are dots of radius size, see update_drawing
+			radius := len(o.points) == 1 ? f32(o.size) : f32(o.size) / 2
+			for point in o.points {
+				min_pos = {min(min_pos.x, point.x - radius), min(min_pos.y, point.y - radius)}
+				max_pos = {max(max_pos.x, point.x + radius), max(max_pos.y, point.y + radius)}
+			}
+		case ImageOperation:
+			min_pos = {min(min_pos.x, o.pos.x), min(min_pos.y, o.pos.y)}
+			max_pos = {
+				max(max_pos.x, o.pos.x + f32(o.width)),
+				max(max_pos.y, o.pos.y + f32(o.height)),
+			}
+		}
+	}
+
+	if min_pos.x > max_pos.x do return {}
+	min_pos = {math.floor(min_pos.x), math.floor(min_pos.y)}
+	return {min_pos.x, min_pos.y, max_pos.x - min_pos.x, max_pos.y - min_pos.y}
+}
@@ -0,0 +1,315 @@
+package yume
+
+import "core:fmt"
+import "core:log"
+import "core:os"
+import "core:slice"
+import "core:strings"
+import "core:time"
+import rl "vendor:raylib"
+
+PROFILER_FRAME_COUNT :: 240 // Completed frames kept, 4s at 60 FPS
+PROFILER_TRACE_PATH :: "profile_trace.json"
+PROFILER_GRAPH_HEIGHT :: 60
+PROFILER_GRAPH_MAX_MS :: 33.3 // Frame time at the top of the graph
+PROFILER_BUDGET_MS :: 1000.0 / 60 // Matches SetTargetFPS(60)
+PROFILER_PADDING :: 8
+
+ProfileZone :: enum {
+	Frame,
+	Update,
+	UpdateCanvas,
+	UpdateToolbar,
+	UpdateDrawing,
+	Draw,
+	DrawCanvas,
+	DrawToolbar,
+	DrawMenu,
+	Present,
+}
+
+profile_zone_names := [ProfileZone]string {
+	.Frame         = "frame",
+	.Update        = "update",
+	.UpdateCanvas  = "update_canvas",
+	.UpdateToolbar = "update_toolbar",
+	.UpdateDrawing = "update_drawing",
+	.Draw          = "draw",
+	.DrawCanvas    = "draw_canvas",
+	.DrawToolbar   = "draw_toolbar",
+	.DrawMenu      = "draw_menu_bar",
+	.Present       = "present",
+}
+
+FrameProfile :: struct {
+	start:       [ProfileZone]f64, // Microseconds since the profiler started, of the first entry
+	// Microseconds, summed over entries. Zones entered more than once in a frame
+	// aren't exported as trace events, see export_chrome_trace.
+	duration:    [ProfileZone]f64,
+	entries:     [ProfileZone]int,
+	ops_drawn:   int,
+	ops_culled:  int,
+	alloc_count: int,
+	alloc_bytes: int,
+}
+
+Profiler :: struct {
+	frames:       [PROFILER_FRAME_COUNT + 1]FrameProfile, // One extra slot for the frame in progress
+	frame_count:  int, // Frames begun so far, the last one is still in progress
+	base:         time.Tick,
+	show_overlay: bool,
+}
+
+create_profiler :: proc() -> Profiler {
+	return Profiler{base = time.tick_now()}
+}
+
+profile_begin_frame :: proc(profiler: ^Profiler) {
+	profiler.frame_count += 1
+	profiler.frames[(profiler.frame_count - 1) % len(profiler.frames)] = {}
+}
+
+get_current_frame :: proc(profiler: ^Profiler) -> ^FrameProfile {
+	return &profiler.frames[max(profiler.frame_count - 1, 0) % len(profiler.frames)]
+}
+
+get_completed_frame_count :: proc(profiler: ^Profiler) -> int {
+	return clamp(profiler.frame_count - 1, 0, PROFILER_FRAME_COUNT)
+}
+
+// age 1 is the most recently completed frame
+get_completed_frame :: proc(profiler: ^Profiler, age: int) -> ^FrameProfile {
+	return &profiler.frames[(profiler.frame_count - 1 - age) % len(profiler.frames)]
+}
+
+// Times the rest of the enclosing scope:
+//   profile_zone(.UpdateCanvas)
+@(deferred_out = profile_zone_end)
+profile_zone :: proc(zone: ProfileZone) -> (ProfileZone, time.Tick) {
+	return zone, time.tick_now()
+}
+
+profile_zone_end :: proc(zone: ProfileZone, start: time.Tick) {
+	profiler := &state.profiler
+	record_zone(
+		profiler,
+		zone,
+		time.duration_microseconds(time.tick_diff(profiler.base, start)),
+		time.duration_microseconds(time.tick_since(start)),
+	)
+}
+
+record_zone :: proc(profiler: ^Profiler, zone: ProfileZone, start, duration: f64) {
+	frame := get_current_frame(profiler)
+
+	if frame.entries[zone] == 0 do frame.start[zone] = start
+	frame.entries[zone] += 1
+	frame.duration[zone] += duration
+}
+
+profile_count_ops :: proc(drawn, culled: int) {
+	frame := get_current_frame(&state.profiler)
+	frame.ops_drawn += drawn
+	frame.ops_culled += culled
+}
+
+// Reported by the host after each frame, from its tracking allocator
+profile_record_allocations :: proc(count, bytes: int) {
+	frame := get_current_frame(&state.profiler)
+	frame.alloc_count += count
+	frame.alloc_bytes += bytes
+}
+
+// Median and 99th percentile over the completed frames in the ring buffer, in microseconds
+get_zone_percentiles :: proc(profiler: ^Profiler, zone: ProfileZone) -> (p50, p99: f64) {
+	count := get_completed_frame_count(profiler)
+	if count == 0 do return
+
+	// Fixed scratch on the stack, so the overlay doesn't show up in the allocation counts
+	scratch: [PROFILER_FRAME_COUNT]f64
+	samples := scratch[:count]
+	for i in 0 ..< count {
+		samples[i] = get_completed_frame(profiler, i + 1).duration[zone]
+	}
+	slice.sort(samples)
+
+	return samples[count / 2], samples[min(count * 99 / 100, count - 1)]
+}
+
+update_profiler :: proc(profiler: ^Profiler) {
+	if !rl.IsKeyPressed(.F3) do return
+
+	if rl.IsKeyDown(.LEFT_SHIFT) || rl.IsKeyDown(.RIGHT_SHIFT) {
+		if !export_chrome_trace(profiler, PROFILER_TRACE_PATH) {
+			log.errorf("Failed to write trace to %v", PROFILER_TRACE_PATH)
+		}
+	} else {
+		profiler.show_overlay = !profiler.show_overlay
+	}
+}
+
+// Formats into a caller owned buffer instead of the temp allocator, keeping the
+// nul terminator raylib needs
+overlay_text :: proc(buf: []u8, format: string, args: ..any) -> cstring {
+	slice.zero(buf)
+	fmt.bprintf(buf[:len(buf) - 1], format, ..args)
+	return cstring(raw_data(buf))
+}
+
+draw_profiler_overlay :: proc(profiler: ^Profiler) {
+	if !profiler.show_overlay do return
+
+	text_buf: [64]u8
+
+	line_height := f32(FONT_SIZE + 2)
+	text_lines := len(ProfileZone) + 3
+	panel := rl.Rectangle {
+		width  = PROFILER_FRAME_COUNT + PROFILER_PADDING * 2,
+		height = PROFILER_GRAPH_HEIGHT + f32(text_lines) * line_height + PROFILER_PADDING * 3,
+	}
+	panel.x = state.window_size.x - panel.width - PROFILER_PADDING
+	panel.y = MENUBAR_HEIGHT + PROFILER_PADDING
+
+	rl.DrawRectangleRec(panel, {0, 0, 0, 200})
+
+	// Frame time graph, newest frame on the right. The full frame includes the
+	// vsync wait in Present, so it sits at the budget when healthy; it is drawn
+	// in grey behind the CPU time, which is what gets checked against the budget.
+	graph := rl.Rectangle {
+		panel.x + PROFILER_PADDING,
+		panel.y + PROFILER_PADDING,
+		PROFILER_FRAME_COUNT,
+		PROFILER_GRAPH_HEIGHT,
+	}
+	count := get_completed_frame_count(profiler)
+	for age in 1 ..= count {
+		frame := get_completed_frame(profiler, age)
+		frame_ms := frame.duration[.Frame] / 1000
+		cpu_ms := (frame.duration[.Frame] - frame.duration[.Present]) / 1000
+		bar_x := graph.x + graph.width - f32(age)
+
+		frame_height := f32(min(frame_ms / PROFILER_GRAPH_MAX_MS, 1)) * graph.height
+		rl.DrawRectangleRec(
+			{bar_x, graph.y + graph.height - frame_height, 1, frame_height},
+			rl.DARKGRAY,
+		)
+
+		cpu_height := f32(min(cpu_ms / PROFILER_GRAPH_MAX_MS, 1)) * graph.height
+		rl.DrawRectangleRec(
+			{bar_x, graph.y + graph.height - cpu_height, 1, cpu_height},
+			cpu_ms > PROFILER_BUDGET_MS ? rl.RED : rl.GREEN,
+		)
+	}
+
+	budget_y := graph.y + graph.height * (1 - PROFILER_BUDGET_MS / PROFILER_GRAPH_MAX_MS)
+	rl.DrawLineV({graph.x, budget_y}, {graph.x + graph.width, budget_y}, rl.YELLOW)
+	rl.DrawRectangleLinesEx(graph, 1, rl.GRAY)
+
+	// Per-zone percentiles and counters
+	name_x := graph.x
+	p50_x := graph.x + graph.width * 0.55
+	p99_x := graph.x + graph.width * 0.8
+	y := graph.y + graph.height + PROFILER_PADDING
+
+	rl.DrawTextEx(ui_font, "zone", {name_x, y}, FONT_SIZE, 1, rl.LIGHTGRAY)
+	rl.DrawTextEx(ui_font, "p50 ms", {p50_x, y}, FONT_SIZE, 1, rl.LIGHTGRAY)
+	rl.DrawTextEx(ui_font, "p99 ms", {p99_x, y}, FONT_SIZE, 1, rl.LIGHTGRAY)
+	y += line_height
+
+	for zone in ProfileZone {
+		p50, p99 := get_zone_percentiles(profiler, zone)
+		name := overlay_text(text_buf[:], "%s", profile_zone_names[zone])
+		rl.DrawTextEx(ui_font, name, {name_x, y}, FONT_SIZE, 1, rl.WHITE)
+		p50_text := overlay_text(text_buf[:], "%.2f", p50 / 1000)
+		rl.DrawTextEx(ui_font, p50_text, {p50_x, y}, FONT_SIZE, 1, rl.WHITE)
+		p99_text := overlay_text(text_buf[:], "%.2f", p99 / 1000)
+		rl.DrawTextEx(ui_font, p99_text, {p99_x, y}, FONT_SIZE, 1, rl.WHITE)
+		y += line_height
+	}
+
+	if count == 0 do return
+	last := get_completed_frame(profiler, 1)
+
+	ops_text := overlay_text(
+		text_buf[:],
+		"ops drawn %d, culled %d",
+		last.ops_drawn,
+		last.ops_culled,
+	)
+	rl.DrawTextEx(ui_font, ops_text, {name_x, y}, FONT_SIZE, 1, rl.WHITE)
+	y += line_height
+
+	alloc_text := overlay_text(
+		text_buf[:],
+		"allocs %d, %d bytes",
+		last.alloc_count,
+		last.alloc_bytes,
+	)
+	rl.DrawTextEx(ui_font, alloc_text, {name_x, y}, FONT_SIZE, 1, rl.WHITE)
+}
+
+// Writes the completed frames in Chrome's trace event format, viewable in
+// chrome://tracing or ui.perfetto.dev
+export_chrome_trace :: proc(profiler: ^Profiler, path: string) -> bool {
+	b := strings.builder_make()
+	defer strings.builder_destroy(&b)
+
+	strings.write_string(&b, `{"displayTimeUnit":"ms","traceEvents":[`)
+
+	first := true
+	count := get_completed_frame_count(profiler)
+	for age := count; age >= 1; age -= 1 {
+		frame := get_completed_frame(profiler, age)
+		if frame.entries[.Frame] == 0 do continue
+
+		// One summed event per re-entered zone would overlap its siblings, so
+		// only zones entered once are exported
+		zones: [len(ProfileZone)]ProfileZone
+		zone_count := 0
+		for zone in ProfileZone {
+			if frame.entries[zone] != 1 do continue
+			zones[zone_count] = zone
+			zone_count += 1
+		}
+
+		// Viewers expect events in timestamp order. Parents come first in the
+		// enum, and the insertion sort is stable, so they stay ahead of children
+		// starting on the same tick.
+		for i in 1 ..< zone_count {
+			for j := i; j > 0 && frame.start[zones[j]] < frame.start[zones[j - 1]]; j -= 1 {
+				zones[j], zones[j - 1] = zones[j - 1], zones[j]
+			}
+		}
+
+		ts := frame.start[.Frame]
+		if !first do strings.write_byte(&b, ',')
+		first = false
+
+		strings.write_string(&b, `{"name":"ops","ph":"C","pid":1,"ts":`)
+		fmt.sbprintf(&b, `%.3f,"args":`, ts)
+		strings.write_string(&b, `{"drawn":`)
+		fmt.sbprintf(&b, `%d,"culled":%d`, frame.ops_drawn, frame.ops_culled)
+		strings.write_string(&b, `}}`)
+
+		strings.write_string(&b, `,{"name":"allocations","ph":"C","pid":1,"ts":`)
+		fmt.sbprintf(&b, `%.3f,"args":`, ts)
+		strings.write_string(&b, `{"count":`)
+		fmt.sbprintf(&b, `%d,"bytes":%d`, frame.alloc_count, frame.alloc_bytes)
+		strings.write_string(&b, `}}`)
+
+		for zone in zones[:zone_count] {
+			strings.write_string(&b, `,{"name":"`)
+			strings.write_string(&b, profile_zone_names[zone])
+			fmt.sbprintf(
+				&b,
+				`","ph":"X","pid":1,"tid":1,"ts":%.3f,"dur":%.3f`,
+				frame.start[zone],
+				frame.duration[zone],
+			)
+			strings.write_byte(&b, '}')
+		}
+	}
+
+	strings.write_string(&b, `]}`)
+	return os.write_entire_file(path, b.buf[:])
+}
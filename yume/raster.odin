@@ -0,0 +1,519 @@
+package yume
+
+import "core:math"
+import "core:mem"
+import "core:os"
+import "core:slice"
+import "core:strings"
+import "core:thread"
+import rl "vendor:raylib"
+
+RASTER_TILE_SIZE :: 64
+RASTER_SPLINE_DIVISIONS :: 24 // Same as raylib's SPLINE_SEGMENT_DIVISIONS
+// Largest buffer ExportImage can write: stb_image_write sizes the filtered
+// PNG rows, (width * 4 + 1) * height bytes, in a C int
+RASTER_MAX_PNG_BYTES :: int(max(i32))
+
+RenderError :: enum {
+	None,
+	Load,
+	TooLarge,
+	OutOfMemory,
+	Export,
+}
+
+// Plain RGBA8 framebuffer for replaying history without a window
+RasterBuffer :: struct {
+	pixels: []rl.Color,
+	width:  i32,
+	height: i32,
+}
+
+RasterStroke :: struct {
+	polyline: []rl.Vector2, // Tessellated spline in output pixels
+	radius:   f32,
+	color:    rl.Color,
+}
+
+RasterImage :: struct {
+	image: rl.Image, // R8G8B8A8
+	dest:  rl.Rectangle,
+}
+
+// An operation resolved to output pixel space, shared read-only by every tile
+RasterOp :: struct {
+	bounds: rl.Rectangle,
+	type:   union {
+		RasterStroke,
+		RasterImage,
+	},
+}
+
+// Polyline segment `index` of stroke `ops[op]`
+RasterSegment :: struct {
+	op:    int,
+	index: int,
+}
+
+RasterTile :: struct {
+	target:        ^RasterBuffer,
+	ops:           []RasterOp,
+	segments:      []RasterSegment, // Stroke segments touching this tile, in op order
+	x, y:          i32,
+	width, height: i32,
+}
+
+create_raster_buffer :: proc(
+	width, height: i32,
+	background := rl.WHITE,
+) -> (
+	buffer: RasterBuffer,
+	err: mem.Allocator_Error,
+) {
+	buffer.pixels = make([]rl.Color, int(width) * int(height)) or_return
+	buffer.width = width
+	buffer.height = height
+	slice.fill(buffer.pixels, background)
+	return
+}
+
+destroy_raster_buffer :: proc(buffer: ^RasterBuffer) {
+	delete(buffer.pixels)
+	buffer^ = {}
+}
+
+// Replays history into the buffer. `origin` is the world position of the buffer's
+// top-left pixel and `scale` maps world units to pixels. Tiles are rendered in
+// parallel; thread_count <= 0 uses every core.
+rasterize_history :: proc(
+	history: ^History,
+	target: ^RasterBuffer,
+	origin: rl.Vector2 = {},
+	scale: f32 = 1,
+	thread_count := 0,
+) {
+	ops := prepare_raster_ops(history, origin, scale)
+	defer destroy_raster_ops(&ops)
+
+	tiles := make([dynamic]RasterTile)
+	defer delete(tiles)
+
+	tiles_x := (int(target.width) + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE
+	tiles_y := (int(target.height) + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE
+
+	bins := bin_stroke_segments(ops[:], tiles_x, tiles_y)
+	defer {
+		for &bin in bins {
+			delete(bin)
+		}
+		delete(bins)
+	}
+
+	for y: i32 = 0; y < target.height; y += RASTER_TILE_SIZE {
+		for x: i32 = 0; x < target.width; x += RASTER_TILE_SIZE {
+			append(
+				&tiles,
+				RasterTile {
+					target = target,
+					ops = ops[:],
+					segments = bins[len(tiles)][:],
+					x = x,
+					y = y,
+					width = min(RASTER_TILE_SIZE, target.width - x),
+					height = min(RASTER_TILE_SIZE, target.height - y),
+				},
+			)
+		}
+	}
+
+	workers := thread_count > 0 ? thread_count : os.processor_core_count()
+	workers = min(workers, len(tiles))
+
+	if workers <= 1 {
+		for &tile in tiles {
+			rasterize_tile(&tile)
+		}
+		return
+	}
+
+	// Tiles write disjoint pixels and only read the ops, so no locking is needed
+	pool: thread.Pool
+	thread.pool_init(&pool, context.allocator, workers)
+	defer thread.pool_destroy(&pool)
+
+	for &tile, idx in tiles {
+		thread.pool_add_task(&pool, context.allocator, rasterize_tile_task, &tile, idx)
+	}
+	thread.pool_start(&pool)
+	thread.pool_finish(&pool)
+}
+
+prepare_raster_ops :: proc(
+	history: ^History,
+	origin: rl.Vector2,
+	scale: f32,
+) -> [dynamic]RasterOp {
+	ops := make([dynamic]RasterOp, 0, len(history.operations))
+
+	last := min(history.curr_index, len(history.operations) - 1)
+	for i := 0; i <= last; i += 1 {
+		op := history.operations[i]
+		if !op.visible do continue
+
+		switch o in op.type {
+		case StrokeOperation:
+			if len(o.points) == 0 do continue
+
+			polyline: []rl.Vector2
+			radius := f32(o.size) / 2 * scale
+			if len(o.points) == 1 {
+				// A click draws a dot of radius size in update_drawing, keep it in exports
+				polyline = make([]rl.Vector2, 1)
+				polyline[0] = (o.points[0] - origin) * scale
+				radius = f32(o.size) * scale
+			} else {
+				polyline = tessellate_stroke(o.points, origin, scale)
+			}
+			append(
+				&ops,
+				RasterOp {
+					bounds = get_polyline_bounds(polyline, radius + 1),
+					type = RasterStroke{polyline = polyline, radius = radius, color = o.color},
+				},
+			)
+		case ImageOperation:
+			if o.image.data == nil do continue
+
+			dest := rl.Rectangle {
+				(o.pos.x - origin.x) * scale,
+				(o.pos.y - origin.y) * scale,
+				f32(o.image.width) * scale,
+				f32(o.image.height) * scale,
+			}
+			append(&ops, RasterOp{bounds = dest, type = RasterImage{image = o.image, dest = dest}})
+		}
+	}
+
+	return ops
+}
+
+// Sorts stroke segments into the row-major tiles they touch, so each tile only
+// visits its own segments instead of every segment of every stroke crossing it
+bin_stroke_segments :: proc(
+	ops: []RasterOp,
+	tiles_x, tiles_y: int,
+) -> [][dynamic]RasterSegment {
+	bins := make([][dynamic]RasterSegment, tiles_x * tiles_y)
+	if len(bins) == 0 do return bins
+
+	// Tile column or row holding coordinate v, as a float clamp so far away
+	// segments can't overflow the int conversion
+	tile_of :: proc(v: f32, count: int) -> int {
+		return int(clamp(math.floor(v / RASTER_TILE_SIZE), 0, f32(count - 1)))
+	}
+
+	extent := rl.Rectangle{0, 0, f32(tiles_x * RASTER_TILE_SIZE), f32(tiles_y * RASTER_TILE_SIZE)}
+
+	for &op, op_index in ops {
+		stroke, ok := op.type.(RasterStroke)
+		if !ok do continue
+
+		reach := stroke.radius + 1
+		last := len(stroke.polyline) - 1
+		for i := 0; i < max(last, 1); i += 1 {
+			rect := get_segment_rect(stroke.polyline[i], stroke.polyline[min(i + 1, last)], reach)
+			if !rl.CheckCollisionRecs(rect, extent) do continue
+
+			tx0, tx1 := tile_of(rect.x, tiles_x), tile_of(rect.x + rect.width, tiles_x)
+			ty0, ty1 := tile_of(rect.y, tiles_y), tile_of(rect.y + rect.height, tiles_y)
+
+			for ty in ty0 ..= ty1 {
+				for tx in tx0 ..= tx1 {
+					append(&bins[ty * tiles_x + tx], RasterSegment{op = op_index, index = i})
+				}
+			}
+		}
+	}
+
+	return bins
+}
+
+get_segment_rect :: proc(a, b: rl.Vector2, reach: f32) -> rl.Rectangle {
+	return rl.Rectangle {
+		min(a.x, b.x) - reach,
+		min(a.y, b.y) - reach,
+		abs(b.x - a.x) + reach * 2,
+		abs(b.y - a.y) + reach * 2,
+	}
+}
+
+destroy_raster_ops :: proc(ops: ^[dynamic]RasterOp) {
+	for op in ops^ {
+		if stroke, ok := op.type.(RasterStroke); ok {
+			delete(stroke.polyline)
+		}
+	}
+	delete(ops^)
+}
+
+// Catmull-Rom tessellation with the same mirrored end controls as draw_stroke
+tessellate_stroke :: proc(points: []rl.Vector2, origin: rl.Vector2, scale: f32) -> []rl.Vector2 {
+	n := len(points)
+	if n == 2 {
+		polyline := make([]rl.Vector2, 2)
+		polyline[0] = (points[0] - origin) * scale
+		polyline[1] = (points[1] - origin) * scale
+		return polyline
+	}
+
+	control := make([]rl.Vector2, n + 2)
+	defer delete(control)
+
+	control[0] = points[0] - (points[1] - points[0])
+	copy(control[1:], points)
+	control[n + 1] = points[n - 1] + (points[n - 1] - points[n - 2])
+
+	polyline := make([]rl.Vector2, (n - 1) * RASTER_SPLINE_DIVISIONS + 1)
+	idx := 0
+	for i := 0; i < n - 1; i += 1 {
+		p0, p1, p2, p3 := control[i], control[i + 1], control[i + 2], control[i + 3]
+
+		for j := 0; j < RASTER_SPLINE_DIVISIONS; j += 1 {
+			t := f32(j) / RASTER_SPLINE_DIVISIONS
+			t2 := t * t
+			t3 := t2 * t
+
+			point :=
+				0.5 *
+				((2 * p1) +
+						(p2 - p0) * t +
+						(2 * p0 - 5 * p1 + 4 * p2 - p3) * t2 +
+						(3 * p1 - p0 - 3 * p2 + p3) * t3)
+			polyline[idx] = (point - origin) * scale
+			idx += 1
+		}
+	}
+	polyline[idx] = (points[n - 1] - origin) * scale
+
+	return polyline
+}
+
+get_polyline_bounds :: proc(points: []rl.Vector2, padding: f32) -> rl.Rectangle {
+	min_pos := points[0]
+	max_pos := points[0]
+	for point in points[1:] {
+		min_pos = {min(min_pos.x, point.x), min(min_pos.y, point.y)}
+		max_pos = {max(max_pos.x, point.x), max(max_pos.y, point.y)}
+	}
+
+	return rl.Rectangle {
+		x = min_pos.x - padding,
+		y = min_pos.y - padding,
+		width = max_pos.x - min_pos.x + padding * 2,
+		height = max_pos.y - min_pos.y + padding * 2,
+	}
+}
+
+rasterize_tile_task :: proc(task: thread.Task) {
+	rasterize_tile((^RasterTile)(task.data))
+}
+
+rasterize_tile :: proc(tile: ^RasterTile) {
+	tile_rect := rl.Rectangle{f32(tile.x), f32(tile.y), f32(tile.width), f32(tile.height)}
+	coverage: [RASTER_TILE_SIZE * RASTER_TILE_SIZE]f32
+
+	// tile.segments is in op order, so each stroke's run is consumed as we go
+	cursor := 0
+	for &op, op_index in tile.ops {
+		switch o in op.type {
+		case RasterStroke:
+			first := cursor
+			for cursor < len(tile.segments) && tile.segments[cursor].op == op_index {
+				cursor += 1
+			}
+			if first == cursor do continue
+
+			rasterize_stroke(tile, o, op.bounds, tile.segments[first:cursor], coverage[:])
+		case RasterImage:
+			if !rl.CheckCollisionRecs(op.bounds, tile_rect) do continue
+
+			rasterize_image(tile, o)
+		}
+	}
+}
+
+// Pixel range of `rect` clipped to the tile, as [x0, x1) x [y0, y1).
+// Clamped as floats so far off-screen ops can't overflow the i32 conversion.
+get_tile_span :: proc(tile: ^RasterTile, rect: rl.Rectangle) -> (x0, y0, x1, y1: i32) {
+	left, top := f32(tile.x), f32(tile.y)
+	right, bottom := f32(tile.x + tile.width), f32(tile.y + tile.height)
+
+	x0 = i32(clamp(math.floor(rect.x), left, right))
+	y0 = i32(clamp(math.floor(rect.y), top, bottom))
+	x1 = i32(clamp(math.ceil(rect.x + rect.width), left, right))
+	y1 = i32(clamp(math.ceil(rect.y + rect.height), top, bottom))
+	return
+}
+
+rasterize_stroke :: proc(
+	tile: ^RasterTile,
+	stroke: RasterStroke,
+	bounds: rl.Rectangle,
+	segments: []RasterSegment,
+	coverage: []f32,
+) {
+	x0, y0, x1, y1 := get_tile_span(tile, bounds)
+	if x0 >= x1 || y0 >= y1 do return
+
+	for y in y0 ..< y1 {
+		row := (y - tile.y) * RASTER_TILE_SIZE - tile.x
+		slice.zero(coverage[row + x0:row + x1])
+	}
+
+	// Coverage is the max over segments rather than a sum, so the overlapping
+	// ends of neighbouring segments don't blend the stroke color twice.
+	// A single point is a zero length segment, i.e. a dot.
+	reach := stroke.radius + 1
+	last := len(stroke.polyline) - 1
+	for segment in segments {
+		a := stroke.polyline[segment.index]
+		b := stroke.polyline[min(segment.index + 1, last)]
+		ab := b - a
+		length_sq := ab.x * ab.x + ab.y * ab.y
+
+		sx0, sy0, sx1, sy1 := get_tile_span(tile, get_segment_rect(a, b, reach))
+
+		for y in sy0 ..< sy1 {
+			row := (y - tile.y) * RASTER_TILE_SIZE - tile.x
+			for x in sx0 ..< sx1 {
+				p := rl.Vector2{f32(x) + 0.5, f32(y) + 0.5}
+				ap := p - a
+
+				t: f32 = 0
+				if length_sq > 0 {
+					t = clamp((ap.x * ab.x + ap.y * ab.y) / length_sq, 0, 1)
+				}
+				d := ap - ab * t
+				dist := math.sqrt(d.x * d.x + d.y * d.y)
+
+				// One pixel wide linear falloff across the edge
+				c := clamp(stroke.radius - dist + 0.5, 0, 1)
+				coverage[row + x] = max(coverage[row + x], c)
+			}
+		}
+	}
+
+	for y in y0 ..< y1 {
+		row := (y - tile.y) * RASTER_TILE_SIZE - tile.x
+		dst := tile.target.pixels[int(y) * int(tile.target.width):]
+		for x in x0 ..< x1 {
+			if coverage[row + x] > 0 {
+				blend_pixel(&dst[x], stroke.color, coverage[row + x])
+			}
+		}
+	}
+}
+
+// Nearest sampling, matching raylib's default TEXTURE_FILTER_POINT
+rasterize_image :: proc(tile: ^RasterTile, img: RasterImage) {
+	if img.dest.width <= 0 || img.dest.height <= 0 do return
+
+	x0, y0, x1, y1 := get_tile_span(tile, img.dest)
+	src := ([^]rl.Color)(img.image.data)
+
+	for y in y0 ..< y1 {
+		v := (f32(y) + 0.5 - img.dest.y) / img.dest.height
+		if v < 0 || v >= 1 do continue
+		sy := min(i32(v * f32(img.image.height)), img.image.height - 1)
+		dst := tile.target.pixels[int(y) * int(tile.target.width):]
+
+		for x in x0 ..< x1 {
+			u := (f32(x) + 0.5 - img.dest.x) / img.dest.width
+			if u < 0 || u >= 1 do continue
+			sx := min(i32(u * f32(img.image.width)), img.image.width - 1)
+
+			blend_pixel(&dst[x], src[int(sy) * int(img.image.width) + int(sx)], 1)
+		}
+	}
+}
+
+// raylib's BLEND_ALPHA is glBlendFunc(SRC_ALPHA, ONE_MINUS_SRC_ALPHA) on all four
+// channels, so alpha is blended like the color channels rather than composited
+blend_pixel :: #force_inline proc(dst: ^rl.Color, src: rl.Color, coverage: f32) {
+	alpha := f32(src.a) / 255 * coverage
+	if alpha <= 0 do return
+
+	inv := 1 - alpha
+	dst.r = u8(f32(src.r) * alpha + f32(dst.r) * inv + 0.5)
+	dst.g = u8(f32(src.g) * alpha + f32(dst.g) * inv + 0.5)
+	dst.b = u8(f32(src.b) * alpha + f32(dst.b) * inv + 0.5)
+	dst.a = u8(f32(src.a) * alpha + f32(dst.a) * inv + 0.5)
+}
+
+// Counts pixels whose channels differ by more than `tolerance`.
+//
+// To diff against the GPU canvas, read it back with LoadImageFromTexture and
+// flip it (render textures are bottom-up). Expect it to differ where:
+//   - raylib's spline quads have no anti-aliasing, so every stroke edge is off by
+//     up to a full channel step; compare with a high tolerance or count mismatches
+//   - infinite mode draws no end caps and fixed mode no round joins
+//   - GPU replay (undo, infinite mode) drops single point strokes
+//   - translucent strokes overlap their own quads and blend more than once
+diff_raster :: proc(a, b: RasterBuffer, tolerance: u8 = 0) -> (mismatched: int, max_delta: u8) {
+	if a.width != b.width || a.height != b.height {
+		return max(len(a.pixels), len(b.pixels)), 255
+	}
+
+	for i in 0 ..< len(a.pixels) {
+		pa, pb := a.pixels[i], b.pixels[i]
+		delta := max(
+			max(pa.r, pb.r) - min(pa.r, pb.r),
+			max(pa.g, pb.g) - min(pa.g, pb.g),
+			max(pa.b, pb.b) - min(pa.b, pb.b),
+			max(pa.a, pb.a) - min(pa.a, pb.a),
+		)
+		max_delta = max(max_delta, delta)
+		if delta > tolerance {
+			mismatched += 1
+		}
+	}
+	return
+}
+
+export_raster_png :: proc(buffer: RasterBuffer, path: string) -> bool {
+	image := rl.Image {
+		data    = raw_data(buffer.pixels),
+		width   = buffer.width,
+		height  = buffer.height,
+		mipmaps = 1,
+		format  = .UNCOMPRESSED_R8G8B8A8,
+	}
+	return bool(rl.ExportImage(image, strings.clone_to_cstring(path, context.temp_allocator)))
+}
+
+// Headless entry point: replays a saved op log into a PNG at the given scale
+render_oplog_to_png :: proc(
+	log_path, png_path: string,
+	scale: f32 = 1,
+	thread_count := 0,
+) -> RenderError {
+	history, header, ok := load_history(log_path)
+	if !ok do return .Load
+	defer destroy_history(&history)
+
+	// Sized in f64 so large scales are rejected instead of wrapping
+	width_f := max(1, math.ceil(f64(header.width) * f64(scale)))
+	height_f := max(1, math.ceil(f64(header.height) * f64(scale)))
+	if width_f * 4 + 1 > f64(RASTER_MAX_PNG_BYTES) ||
+	   (width_f * 4 + 1) * height_f > f64(RASTER_MAX_PNG_BYTES) {
+		return .TooLarge
+	}
+
+	buffer, alloc_err := create_raster_buffer(i32(width_f), i32(height_f))
+	if alloc_err != nil do return .OutOfMemory
+	defer destroy_raster_buffer(&buffer)
+
+	rasterize_history(&history, &buffer, header.origin, scale, thread_count)
+	if !export_raster_png(buffer, png_path) do return .Export
+	return .None
+}
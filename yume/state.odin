@@ -34,6 +34,7 @@ State :: struct {
 	draw_state:           DrawState,
 	is_undo_combo_active: bool,
 	is_redo_combo_active: bool,
+	profiler:             Profiler,
 }
 
 /// Globals
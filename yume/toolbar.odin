@@ -98,6 +98,8 @@ draw_tooltip :: proc(button: ToolButton) {
 }
 
 update_toolbar :: proc() {
+	profile_zone(.UpdateToolbar)
+
 	mouse_pos := rl.GetMousePosition()
 	toolbar_state.hover_tool = nil
 	for button in toolbar_buttons {
@@ -143,6 +145,8 @@ update_toolbar :: proc() {
 }
 
 draw_toolbar :: proc() {
+	profile_zone(.DrawToolbar)
+
 	rl.DrawRectangle(
 		0,
 		MENUBAR_HEIGHT,
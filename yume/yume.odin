@@ -5,6 +5,8 @@ import rl "vendor:raylib"
 
 
 update :: proc() {
+	profile_zone(.Update)
+
 	state.window_size = {f32(rl.GetScreenWidth()), f32(rl.GetScreenHeight())}
 
 	// Handle dropped files
@@ -45,6 +47,7 @@ update :: proc() {
 	}
 
 
+	update_profiler(&state.profiler)
 	update_canvas(&state.canvas)
 	update_toolbar()
 
@@ -53,6 +56,8 @@ update :: proc() {
 
 
 draw :: proc() {
+	profile_zone(.Draw)
+
 	rl.BeginDrawing()
 	switch state.canvas.mode {
 	case .Fixed:
@@ -96,16 +101,31 @@ draw :: proc() {
 
 	draw_menu_bar()
 	draw_toolbar()
-	rl.EndDrawing()
+	draw_profiler_overlay(&state.profiler)
+
+	{
+		profile_zone(.Present)
+		rl.EndDrawing()
+	}
 }
 
 @(export)
 yume_update :: proc() -> bool {
-	update()
-	draw()
+	profile_begin_frame(&state.profiler)
+	{
+		profile_zone(.Frame)
+		update()
+		draw()
+	}
 	return !rl.WindowShouldClose()
 }
 
+// Called by the host after yume_update with what its allocator saw during the frame
+@(export)
+yume_profile_allocations :: proc(count, bytes: int) {
+	profile_record_allocations(count, bytes)
+}
+
 @(export)
 yume_init_window :: proc() {
 	rl.SetConfigFlags({.WINDOW_RESIZABLE, .VSYNC_HINT, .WINDOW_TOPMOST, .MSAA_4X_HINT})
@@ -132,6 +152,7 @@ yume_init :: proc() {
 		window_size     = {1280, 720},
 		canvas          = create_canvas(800, 600),
 		draw_state      = create_draw_state(),
+		profiler        = create_profiler(),
 	}
 
 	yume_hot_reloaded(state)